@@ -85,13 +85,8 @@ main(int argc, char** argv)
   ndn::security::v2::Certificate cert = key.getDefaultCertificate();
 
   ndn::ndnabac::AttributeAuthority aa(cert, *face, keyChain);
-  try {
-    boost::asio::io_service::work ioServiceWork(*io_service);
-    io_service->run();
-  }
-  catch (const std::exception& e) {
-    std::cout << "Start IO service or Face failed" << std::endl;
-    return 1;
-  }
+  ndn::ndnabacdaemon::IoServiceManager ioServiceManager(*io_service, *face);
+  ioServiceManager.addPrefix(ndn::Name(aaName));
+  ioServiceManager.run();
   return 0;
 }
@@ -19,17 +19,22 @@
  */
 
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/signal_set.hpp>
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/parsers.hpp>
 #include <ndnabac/consumer.hpp>
 #include <ndn-cxx/util/io.hpp>
 
+#include <csignal>
 #include <thread>
 
 #include "abac-identity.hpp"
+#include "consumer-service.hpp"
+#include "content-cache.hpp"
 #include "ndnabacdaemon-common.hpp"
 #include "io-service-manager.hpp"
+#include "output-sink.hpp"
 
 void
 printUsage(std::ostream& os, const std::string& programName)
@@ -46,7 +51,19 @@ printUsage(std::ostream& os, const std::string& programName)
      << "  [--path]    - path to the certificate"
      << "(default: " << "./%consumerPrefix%/cert" << ")\n"
      << "  [--tokenIssuerName]    - token issuer name\n"
-     << "  [--aname]   - name of attribute authority"
+     << "  [--aname]   - name of attribute authority\n"
+     << "  [--cache-size]    - bytes of decrypted content kept in memory"
+     << "(default: " << 64 * 1024 * 1024 << ")\n"
+     << "  [--freshness]     - milliseconds a decrypted content stays fresh"
+     << "(default: " << 10000 << ")\n"
+     << "  [--spill-path]    - file keeping encrypted content evicted from memory\n"
+     << "  [--spill-size]    - bytes of content kept in the spill file"
+     << "(default: " << 1024 * 1024 * 1024 << ")\n"
+     << "  [--socket]        - serve local clients on this Unix domain socket "
+     << "instead of reading requests from stdin\n"
+     << "  [--output]        - file or pipe receiving decrypted content"
+     << "(default: " << "-" << " for stdout)\n"
+     << "  [--compressed]    - ask producers for compressed content\n"
      ;
 }
 
@@ -61,12 +78,25 @@ main(int argc, char** argv)
   std::string pathToCert = "."+consumerName+"/cert";
   std::string tokenIssuerName = "/tokenIssuerPrefix";
   std::string attributeAuthorityName = "/aaPrefix";
+  size_t cacheSize = 64 * 1024 * 1024;
+  uint64_t freshness = 10000;
+  std::string spillPath;
+  size_t spillSize = 1024 * 1024 * 1024;
+  std::string socketPath;
+  std::string outputPath = "-";
   description.add_options()
     ("help,h", "print this help message")
     ("name,n", po::value<std::string>(&consumerName), "Consumer Name")
     ("path,p", po::value<std::string>(&pathToCert), "Path to Cert")
     ("tokenIssuerName,t", po::value<std::string>(&tokenIssuerName), "Token Issuer Name")
     ("attributeAuthorityName, a", po::value<std::string>(&attributeAuthorityName), "Attribute Authority Name")
+    ("cache-size", po::value<size_t>(&cacheSize), "Content cache size in bytes")
+    ("freshness", po::value<uint64_t>(&freshness), "Content freshness in milliseconds")
+    ("spill-path", po::value<std::string>(&spillPath), "Path to content spill file")
+    ("spill-size", po::value<size_t>(&spillSize), "Spill file size in bytes")
+    ("socket,s", po::value<std::string>(&socketPath), "Path to Unix domain socket")
+    ("output,o", po::value<std::string>(&outputPath), "Path to output file")
+    ("compressed", "Request compressed content")
     ;
 
   po::variables_map vm;
@@ -100,37 +130,136 @@ main(int argc, char** argv)
   certFile.close();
   ndn::ndnabac::Consumer consumer(cert, *face, keyChain, ndn::Name(attributeAuthorityName));
 
-  ndn::ndnabacdaemon::IoServiceManager* ioServiceManager = new ndn::ndnabacdaemon::IoServiceManager(*ioService);
+  // The consume callback only exposes the plaintext, not the Data packet, so
+  // the FreshnessPeriod of cached content comes from --freshness.
+  ndn::ndnabacdaemon::ContentCache contentCache(cacheSize);
+  if (!spillPath.empty()) {
+    contentCache.enableSpill(spillPath, spillSize);
+  }
+  std::unique_ptr<ndn::ndnabacdaemon::OutputSink> sink;
+  try {
+    sink.reset(new ndn::ndnabacdaemon::OutputSink(outputPath));
+  }
+  catch (const ndn::ndnabacdaemon::OutputSink::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+  // a closed downstream pipe surfaces as an OutputSink::Error instead of killing us
+  std::signal(SIGPIPE, SIG_IGN);
+  // payloads are coalesced in the sink and flushed once the io thread has no
+  // more completions queued, so bursts go out in few large writes
+  bool isFlushScheduled = false;
+  // every result is framed like on the socket, "OK <name> <length>\n" and the
+  // payload or "ERR <name> <reason>\n", since results arrive in completion order
+  auto onResult = [&] (const std::string& header, const ndn::Buffer* payload) {
+    try {
+      sink->write(reinterpret_cast<const uint8_t*>(header.data()), header.size());
+      if (payload != nullptr) {
+        sink->write(*payload);
+      }
+    }
+    catch (const ndn::ndnabacdaemon::OutputSink::Error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+    }
+    if (isFlushScheduled) {
+      return;
+    }
+    isFlushScheduled = true;
+    ioService->post([&] {
+      isFlushScheduled = false;
+      try {
+        sink->flush();
+      }
+      catch (const ndn::ndnabacdaemon::OutputSink::Error& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+      }
+    });
+  };
+  ndn::ndnabacdaemon::ConsumerService service(*ioService, consumer, tokenIssuerName, contentCache,
+                                              ndn::time::milliseconds(freshness),
+                                              vm.count("compressed") > 0);
+
+  ndn::ndnabacdaemon::IoServiceManager* ioServiceManager = new ndn::ndnabacdaemon::IoServiceManager(*ioService, *face);
+  auto stop = [&] {
+    service.stop();
+    ioServiceManager->handle_stop();
+  };
+  // only the socket service needs a clean shutdown, stdin mode keeps the default Ctrl-C
+  std::unique_ptr<boost::asio::signal_set> signals;
   try {
+    if (!socketPath.empty()) {
+      service.listen(socketPath);
+      signals.reset(new boost::asio::signal_set(*ioService, SIGINT, SIGTERM));
+      signals->async_wait([&] (const boost::system::error_code&, int) { stop(); });
+    }
     std::thread m_NetworkThread =
         std::thread(&ndn::ndnabacdaemon::IoServiceManager::run, ioServiceManager);
+    if (!socketPath.empty()) {
+      m_NetworkThread.join();
+      return 0;
+    }
+
+    // both only touched on the io thread
+    size_t nPending = 0;
+    bool isInputDone = false;
+    auto onFetched = [&] {
+      if (--nPending == 0 && isInputDone) {
+        stop();
+      }
+    };
+
     std::string line;
     while(std::getline(std::cin, line)) {
       if (line == "quit") {
-        return 1;
+        break;
       }
       std::size_t pos = line.find(",");
       if (pos == std::string::npos) {
         std::cerr << "ERROR: " << "config format error" << std::endl;
-        return 1;
+        continue;
+      }
+      ndn::Name contentName;
+      try {
+        ndn::Name producerName = line.substr(0, pos);
+        ndn::Name dataName = line.substr(pos+1);
+        contentName = producerName.append(dataName);
       }
-      ndn::Name producerName = line.substr(0, pos);
-      ndn::Name dataName = line.substr(pos+1);
-      consumer.consume(producerName.append(dataName), tokenIssuerName, 
-        [&] (const ndn::Buffer& result) {
-          std::string str;
-          for(int i =0;i<sizeof(result);++i)
-            str.push_back(result[i]);
-          std::cout<<str<<std::endl;
-        },
-        [&] (const std::string& err) {
-          std::cout << "error occurred" << err << std::endl;
+      catch (const ndn::tlv::Error& e) {
+        std::cerr << "ERROR: " << "invalid name in " << line << ": " << e.what() << std::endl;
+        continue;
+      }
+      // the Face and the consumer are only touched from the io thread
+      ioService->post([&, contentName] {
+        ++nPending;
+        service.fetch(contentName,
+          [&, contentName] (const ndn::ConstBufferPtr& content) {
+            onResult("OK " + contentName.toUri() + " " + std::to_string(content->size()) + "\n",
+                     content.get());
+            onFetched();
+          },
+          [&, contentName] (const std::string& err) {
+            std::cerr << "error occurred" << err << std::endl;
+            onResult("ERR " + contentName.toUri() + " " + err + "\n", nullptr);
+            onFetched();
+          });
       });
     }
+    // let the fetches still in flight finish before stopping
+    ioService->post([&] {
+      isInputDone = true;
+      if (nPending == 0) {
+        stop();
+      }
+    });
+    m_NetworkThread.join();
+  }
+  catch (const ndn::ndnabacdaemon::ConsumerService::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
   }
   catch (const std::exception& e) {
-    std::cout << "Start IO service or Face failed" << std::endl;
+    std::cerr << "Start IO service or Face failed" << std::endl;
     return 1;
   }
 	return 0;
-}
\ No newline at end of file
+}
@@ -25,6 +25,7 @@
 #include <ndnabac/data-owner.hpp>
 
 #include "abac-identity.hpp"
+#include "policy-syntax.hpp"
 #include "ndnabacdaemon-common.hpp"
 
 void
@@ -106,6 +107,14 @@ main(int argc, char** argv)
 
   		ndn::Name dataName = line.substr(0, pos);
   		std::string policy = line.substr(pos+1);
+      // reject malformed policies before they reach the producer
+      try {
+        ndn::ndnabacdaemon::checkPolicy(policy);
+      }
+      catch (const ndn::ndnabacdaemon::PolicyError& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+      }
 		  bool isPolicySet = false;
 		  dataOwner.commandProducerPolicy(producerName, dataName, policy,
 		                                   [&] (const ndn::Data& response) {
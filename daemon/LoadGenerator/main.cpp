@@ -0,0 +1,475 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include <boost/algorithm/string.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <ndnabac/attribute-authority.hpp>
+#include <ndnabac/consumer.hpp>
+#include <ndnabac/data-owner.hpp>
+#include <ndnabac/token-issuer.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/io.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <fstream>
+#include <list>
+#include <map>
+#include <random>
+
+#include "abac-identity.hpp"
+#include "content-cache.hpp"
+#include "latency-histogram.hpp"
+#include "ndnabacdaemon-common.hpp"
+#include "producer-host.hpp"
+
+void
+printUsage(std::ostream& os, const std::string& programName)
+{
+  os << "Usage: \n"
+     << "  " << programName << " [options]\n"
+     << "\n"
+     << "VO-NDN open-loop load generator\n"
+     << "\n"
+     << "Options:\n"
+     << "  [--help]          - print this help message\n"
+     << "  [--consumers]     - number of synthetic consumers"
+     << "(default: " << 10 << ")\n"
+     << "  [--attributes]    - comma separated attribute set, may be repeated; "
+     << "consumers take the sets round-robin(default: " << "attr1,attr3" << ")\n"
+     << "  [--producer]      - producer name"
+     << "(default: " << "/Producer" << ")\n"
+     << "  [--data]          - data name, may be repeated"
+     << "(default: " << "/data1" << ")\n"
+     << "  [--tokenIssuerName] - token issuer name"
+     << "(default: " << "/TokenIssuer" << ")\n"
+     << "  [--aname]         - name of attribute authority"
+     << "(default: " << "/aaPrefix" << ")\n"
+     << "  [--rate]          - requests per second"
+     << "(default: " << 10 << ")\n"
+     << "  [--arrival]       - poisson or fixed"
+     << "(default: " << "poisson" << ")\n"
+     << "  [--duration]      - seconds of traffic"
+     << "(default: " << 30 << ")\n"
+     << "  [--warmup]        - seconds to wait before traffic starts"
+     << "(default: " << 5 << ")\n"
+     << "  [--timeout]       - seconds to wait for outstanding requests"
+     << "(default: " << 10 << ")\n"
+     << "  [--config]        - token issuer config written for the consumers"
+     << "(default: " << "loadgenConsumer.txt" << ")\n"
+     << "  [--cert-dir]      - directory receiving consumer certificates"
+     << "(default: " << "." << ")\n"
+     << "  [--csv]           - latency CSV output"
+     << "(default: " << "loadgen.csv" << ")\n"
+     << "  [--dummy]         - run authority, token issuer, data owner and producer "
+     << "in process on a dummy face instead of using NFD\n"
+     << "  [--producer-config] - producer data file used with --dummy"
+     << "(default: " << "producerDataFile.txt" << ")\n"
+     << "  [--policy]        - policy set on every data name with --dummy"
+     << "(default: " << "attr1 attr2 1of2 attr3 2of2" << ")\n"
+     << "  [--seed]          - random seed\n"
+     ;
+}
+
+namespace {
+
+struct SyntheticConsumer
+{
+  ndn::Name name;
+  std::list<std::string> attributes;
+  ndn::security::v2::Certificate cert;
+  std::unique_ptr<ndn::ndnabac::Consumer> consumer;
+};
+
+struct LoadStats
+{
+  // successes, and unfinished requests charged up to the end of the run
+  ndn::ndnabacdaemon::LatencyHistogram histogram;
+  // failures, measured like successes up to the error
+  ndn::ndnabacdaemon::LatencyHistogram failureHistogram;
+  uint64_t nSent = 0;
+  uint64_t nSucceeded = 0;
+  uint64_t nFailed = 0;
+  uint64_t nOutstanding = 0;
+  ndn::time::nanoseconds maxLag = ndn::time::nanoseconds::zero();
+};
+
+// Issues requests at intended times drawn from the arrival process.  Latency
+// is measured from the intended time, not from when the request actually went
+// out, so a stalled sender is charged for the queueing it caused.
+class OpenLoopDriver
+{
+public:
+  OpenLoopDriver(boost::asio::io_service& io, std::vector<SyntheticConsumer>& consumers,
+                 const std::vector<ndn::Name>& names, const ndn::Name& tokenIssuerName,
+                 double rate, bool isPoisson, ndn::time::nanoseconds duration, uint32_t seed)
+    : m_scheduler(io)
+    , m_consumers(consumers)
+    , m_names(names)
+    , m_tokenIssuerName(tokenIssuerName)
+    , m_rate(rate)
+    , m_isPoisson(isPoisson)
+    , m_duration(duration)
+    , m_random(seed)
+  {
+  }
+
+  void
+  start()
+  {
+    m_start = ndn::time::steady_clock::now();
+    m_intended = m_start;
+    scheduleNext();
+  }
+
+  // Charge the requests still outstanding at @p end with the time they waited,
+  // so a run whose tail never completes cannot report a flattering percentile.
+  void
+  finish(ndn::time::steady_clock::TimePoint end)
+  {
+    for (const auto& outstanding : m_outstanding) {
+      m_stats.histogram.record(toMicros(end - outstanding.second));
+    }
+  }
+
+  const LoadStats&
+  getStats() const
+  {
+    return m_stats;
+  }
+
+private:
+  void
+  scheduleNext()
+  {
+    double gap = m_isPoisson ? std::exponential_distribution<double>(m_rate)(m_random)
+                             : 1.0 / m_rate;
+    m_intended += ndn::time::nanoseconds(static_cast<int64_t>(gap * 1e9));
+    if (m_intended - m_start > m_duration) {
+      return;
+    }
+    auto delay = m_intended - ndn::time::steady_clock::now();
+    if (delay < ndn::time::nanoseconds::zero()) {
+      delay = ndn::time::nanoseconds::zero();
+    }
+    auto intended = m_intended;
+    m_scheduler.scheduleEvent(delay, [this, intended] {
+      send(intended);
+      scheduleNext();
+    });
+  }
+
+  void
+  send(ndn::time::steady_clock::TimePoint intended)
+  {
+    auto lag = ndn::time::steady_clock::now() - intended;
+    m_stats.maxLag = std::max(m_stats.maxLag, ndn::time::duration_cast<ndn::time::nanoseconds>(lag));
+
+    SyntheticConsumer& consumer = m_consumers[m_random() % m_consumers.size()];
+    const ndn::Name& name = m_names[m_random() % m_names.size()];
+    uint64_t id = m_stats.nSent++;
+    ++m_stats.nOutstanding;
+    m_outstanding[id] = intended;
+    consumer.consumer->consume(name, m_tokenIssuerName,
+      [this, id] (const ndn::Buffer&) {
+        complete(id, true);
+      },
+      [this, id] (const std::string&) {
+        complete(id, false);
+      });
+  }
+
+  void
+  complete(uint64_t id, bool isSuccess)
+  {
+    auto it = m_outstanding.find(id);
+    if (it == m_outstanding.end()) {
+      return;
+    }
+    uint64_t latency = toMicros(ndn::time::steady_clock::now() - it->second);
+    m_outstanding.erase(it);
+    --m_stats.nOutstanding;
+    if (!isSuccess) {
+      ++m_stats.nFailed;
+      m_stats.failureHistogram.record(latency);
+      return;
+    }
+    ++m_stats.nSucceeded;
+    m_stats.histogram.record(latency);
+  }
+
+  static uint64_t
+  toMicros(ndn::time::steady_clock::Duration duration)
+  {
+    return ndn::time::duration_cast<ndn::time::microseconds>(duration).count();
+  }
+
+private:
+  ndn::util::scheduler::Scheduler m_scheduler;
+  std::vector<SyntheticConsumer>& m_consumers;
+  std::vector<ndn::Name> m_names;
+  ndn::Name m_tokenIssuerName;
+  double m_rate;
+  bool m_isPoisson;
+  ndn::time::nanoseconds m_duration;
+  std::mt19937 m_random;
+  ndn::time::steady_clock::TimePoint m_start;
+  ndn::time::steady_clock::TimePoint m_intended;
+  // intended send time of each request still waiting for a reply
+  std::map<uint64_t, ndn::time::steady_clock::TimePoint> m_outstanding;
+  LoadStats m_stats;
+};
+
+void
+writeCsv(std::ostream& os, const LoadStats& stats, double rate, double seconds)
+{
+  const auto& histogram = stats.histogram;
+  os << "metric,value\n"
+     << "target_rate," << rate << "\n"
+     << "sent," << stats.nSent << "\n"
+     << "succeeded," << stats.nSucceeded << "\n"
+     << "failed," << stats.nFailed << "\n"
+     << "unfinished," << stats.nOutstanding << "\n"
+     << "achieved_rate," << (seconds > 0 ? stats.nSucceeded / seconds : 0) << "\n"
+     << "max_send_lag_us,"
+     << ndn::time::duration_cast<ndn::time::microseconds>(stats.maxLag).count() << "\n"
+     << "min_us," << histogram.min() << "\n"
+     << "mean_us," << histogram.mean() << "\n";
+  for (double quantile : {0.5, 0.9, 0.99, 0.999, 0.9999}) {
+    os << "p" << quantile * 100 << "_us," << histogram.percentile(quantile) << "\n";
+  }
+  os << "max_us," << histogram.max() << "\n";
+
+  const auto& failures = stats.failureHistogram;
+  os << "failed_min_us," << failures.min() << "\n"
+     << "failed_mean_us," << failures.mean() << "\n"
+     << "failed_p50_us," << failures.percentile(0.5) << "\n"
+     << "failed_p99_us," << failures.percentile(0.99) << "\n"
+     << "failed_max_us," << failures.max() << "\n"
+     << "\n";
+  histogram.writeCsv(os);
+  if (failures.count() > 0) {
+    os << "\n";
+    failures.writeCsv(os);
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  namespace po = boost::program_options;
+
+  po::options_description description;
+
+  size_t nConsumers = 10;
+  std::vector<std::string> attributeSets;
+  std::string producerName = "/Producer";
+  std::vector<std::string> dataNames;
+  std::string tokenIssuerName = "/TokenIssuer";
+  std::string aaName = "/aaPrefix";
+  double rate = 10;
+  std::string arrival = "poisson";
+  double duration = 30;
+  double warmup = 5;
+  double timeout = 10;
+  std::string configFile = "loadgenConsumer.txt";
+  std::string certDir = ".";
+  std::string csvFile = "loadgen.csv";
+  std::string producerConfig = "producerDataFile.txt";
+  std::string policy = "attr1 attr2 1of2 attr3 2of2";
+  uint32_t seed = std::random_device()();
+  description.add_options()
+    ("help,h", "print this help message")
+    ("consumers,n", po::value<size_t>(&nConsumers), "Number of consumers")
+    ("attributes", po::value<std::vector<std::string>>(&attributeSets), "Attribute set")
+    ("producer,p", po::value<std::string>(&producerName), "Producer Name")
+    ("data,d", po::value<std::vector<std::string>>(&dataNames), "Data Name")
+    ("tokenIssuerName,t", po::value<std::string>(&tokenIssuerName), "Token Issuer Name")
+    ("aname,a", po::value<std::string>(&aaName), "Attribute Authority Name")
+    ("rate,r", po::value<double>(&rate), "Requests per second")
+    ("arrival", po::value<std::string>(&arrival), "Arrival process")
+    ("duration", po::value<double>(&duration), "Traffic duration in seconds")
+    ("warmup", po::value<double>(&warmup), "Warmup in seconds")
+    ("timeout", po::value<double>(&timeout), "Drain timeout in seconds")
+    ("config,c", po::value<std::string>(&configFile), "Token issuer config output path")
+    ("cert-dir", po::value<std::string>(&certDir), "Certificate output directory")
+    ("csv", po::value<std::string>(&csvFile), "CSV output path")
+    ("dummy", "Use an in-process dummy face")
+    ("producer-config", po::value<std::string>(&producerConfig), "Producer data file")
+    ("policy", po::value<std::string>(&policy), "Policy for in-process producer")
+    ("seed", po::value<uint32_t>(&seed), "Random seed")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(description).run(), vm);
+    po::notify(vm);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    printUsage(std::cerr, argv[0]);
+    return 1;
+  }
+
+  if (vm.count("help") > 0) {
+    printUsage(std::cout, argv[0]);
+    return 0;
+  }
+
+  if (nConsumers == 0 || rate <= 0 || (arrival != "poisson" && arrival != "fixed")) {
+    std::cerr << "ERROR: " << "invalid consumer count, rate or arrival process" << std::endl;
+    printUsage(std::cerr, argv[0]);
+    return 1;
+  }
+  if (attributeSets.empty()) {
+    attributeSets.push_back("attr1,attr3");
+  }
+  if (dataNames.empty()) {
+    dataNames.push_back("/data1");
+  }
+  bool isDummy = vm.count("dummy") > 0;
+
+  std::unique_ptr<boost::asio::io_service> ioService(new boost::asio::io_service);
+  ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
+  std::unique_ptr<ndn::Face> face;
+  if (isDummy) {
+    auto dummyFace = new ndn::util::DummyClientFace(*ioService, keyChain, {false, true});
+    // loop every packet back into the same face so in-process components answer each other
+    dummyFace->onSendInterest.connect([&ioService, dummyFace] (const ndn::Interest& interest) {
+      ioService->post([dummyFace, interest] { dummyFace->receive(interest); });
+    });
+    dummyFace->onSendData.connect([&ioService, dummyFace] (const ndn::Data& data) {
+      ioService->post([dummyFace, data] { dummyFace->receive(data); });
+    });
+    face.reset(dummyFace);
+  }
+  else {
+    face.reset(new ndn::Face(*ioService));
+  }
+
+  // set up consumers and the token issuer config describing them
+  std::vector<SyntheticConsumer> consumers(nConsumers);
+  std::ofstream config(configFile);
+  if (!config.is_open()) {
+    std::cerr << "ERROR: " << "cannot write " << configFile << std::endl;
+    return 1;
+  }
+  for (size_t i = 0; i < nConsumers; ++i) {
+    SyntheticConsumer& consumer = consumers[i];
+    consumer.name = ndn::Name("/loadgen").append("consumer" + std::to_string(i));
+    const std::string& attributes = attributeSets[i % attributeSets.size()];
+    boost::split(consumer.attributes, attributes, [](char c){return c == ',';});
+
+    ndn::security::Identity identity = ndn::ndnabacdaemon::addIdentity(consumer.name, keyChain);
+    consumer.cert = identity.getDefaultKey().getDefaultCertificate();
+    std::string certPath = certDir + "/consumer" + std::to_string(i) + ".cert";
+    ndn::io::save(consumer.cert, certPath);
+    config << consumer.name << "," << attributes << "\n" << certPath << "\n";
+
+    consumer.consumer.reset(new ndn::ndnabac::Consumer(consumer.cert, *face, keyChain,
+                                                       ndn::Name(aaName)));
+  }
+  config.close();
+
+  // in-process authority, token issuer, producer and data owner for offline runs
+  std::unique_ptr<ndn::ndnabac::AttributeAuthority> aa;
+  std::unique_ptr<ndn::ndnabac::TokenIssuer> tokenIssuer;
+  std::unique_ptr<ndn::ndnabac::DataOwner> dataOwner;
+  std::unique_ptr<ndn::ndnabacdaemon::ContentCache> contentCache;
+  std::unique_ptr<ndn::ndnabacdaemon::ProducerHost> producerHost;
+  if (isDummy) {
+    auto aaIdentity = ndn::ndnabacdaemon::addIdentity(aaName, keyChain);
+    aa.reset(new ndn::ndnabac::AttributeAuthority(
+      aaIdentity.getDefaultKey().getDefaultCertificate(), *face, keyChain));
+
+    auto tiIdentity = ndn::ndnabacdaemon::addIdentity(tokenIssuerName, keyChain);
+    tokenIssuer.reset(new ndn::ndnabac::TokenIssuer(
+      tiIdentity.getDefaultKey().getDefaultCertificate(), *face, keyChain));
+    for (const auto& consumer : consumers) {
+      tokenIssuer->insertAttributes(std::make_pair(consumer.name, consumer.attributes));
+      tokenIssuer->addCert(consumer.cert);
+    }
+
+    contentCache.reset(new ndn::ndnabacdaemon::ContentCache(64 * 1024 * 1024));
+    producerHost.reset(new ndn::ndnabacdaemon::ProducerHost(
+      *face, keyChain, ndn::Name(aaName), 1, *contentCache, ndn::time::seconds(10), 0));
+    try {
+      producerHost->addTenant(ndn::Name(producerName), producerConfig);
+    }
+    catch (const ndn::ndnabacdaemon::ProducerHost::Error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return 1;
+    }
+
+    auto doIdentity = ndn::ndnabacdaemon::addIdentity("/loadgen/DataOwner", keyChain);
+    dataOwner.reset(new ndn::ndnabac::DataOwner(
+      doIdentity.getDefaultKey().getDefaultCertificate(), *face, keyChain));
+    for (const auto& dataName : dataNames) {
+      dataOwner->commandProducerPolicy(ndn::Name(producerName), ndn::Name(dataName), policy,
+        [] (const ndn::Data&) {},
+        [] (const std::string& err) { std::cerr << "ERROR: " << err << std::endl; });
+    }
+  }
+  else {
+    std::cout << "start token_issuer with --config=\"" << configFile << "\" within "
+              << warmup << " seconds" << std::endl;
+  }
+
+  std::vector<ndn::Name> names;
+  for (const auto& dataName : dataNames) {
+    names.push_back(ndn::Name(producerName).append(ndn::Name(dataName)));
+  }
+  OpenLoopDriver driver(*ioService, consumers, names, tokenIssuerName, rate,
+                        arrival == "poisson",
+                        ndn::time::nanoseconds(static_cast<int64_t>(duration * 1e9)), seed);
+
+  ndn::util::scheduler::Scheduler scheduler(*ioService);
+  auto toDuration = [] (double seconds) {
+    return ndn::time::nanoseconds(static_cast<int64_t>(seconds * 1e9));
+  };
+  scheduler.scheduleEvent(toDuration(warmup), [&] { driver.start(); });
+  scheduler.scheduleEvent(toDuration(warmup + duration + timeout), [&] { ioService->stop(); });
+
+  try {
+    boost::asio::io_service::work ioServiceWork(*ioService);
+    ioService->run();
+  }
+  catch (const std::exception& e) {
+    std::cout << "Start IO service or Face failed" << std::endl;
+    return 1;
+  }
+
+  driver.finish(ndn::time::steady_clock::now());
+  const LoadStats& stats = driver.getStats();
+  std::ofstream csv(csvFile);
+  if (!csv.is_open()) {
+    std::cerr << "ERROR: " << "cannot write " << csvFile << std::endl;
+    return 1;
+  }
+  writeCsv(csv, stats, rate, duration);
+  std::cout << "sent " << stats.nSent << ", succeeded " << stats.nSucceeded
+            << ", failed " << stats.nFailed << ", unfinished " << stats.nOutstanding
+            << ", p99 " << stats.histogram.percentile(0.99) << "us" << std::endl;
+  return 0;
+}
@@ -22,13 +22,14 @@
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/parsers.hpp>
-#include <ndnabac/producer.hpp>
 
 #include <thread>
 
 #include "abac-identity.hpp"
+#include "content-cache.hpp"
 #include "ndnabacdaemon-common.hpp"
 #include "io-service-manager.hpp"
+#include "producer-host.hpp"
 
 void
 printUsage(std::ostream& os, const std::string& programName)
@@ -44,6 +45,17 @@ printUsage(std::ostream& os, const std::string& programName)
      << "(default: " << "/producerPrefix" << ")\n"
      << "  [--aaName]    - assign the attribute authority name"
      << "(default: " << "/aaPrefix" << ")\n"
+     << "  [--compress]    - zlib level (1-9) applied before encryption for consumers "
+     << "asking for compressed content"
+     << "(default: " << 0 << ", disabled)\n"
+     << "  [--manifest]    - file of \"producerName,configFile\" lines, "
+     << "one per hosted producer, used instead of --pname and --config\n"
+     << "  [--workers]     - threads reading and compressing content"
+     << "(default: " << 4 << ")\n"
+     << "  [--cache-size]  - bytes of prepared content shared by all producers"
+     << "(default: " << 256 * 1024 * 1024 << ")\n"
+     << "  [--freshness]   - milliseconds a cached content stays valid"
+     << "(default: " << 10000 << ")\n"
      ;
 }
 
@@ -57,11 +69,21 @@ main(int argc, char** argv)
   std::string producerName = "/producerPrefix";
   std::string aaName = "/aaPrefix";
   std::string configFile;
+  int compressLevel = 0;
+  std::string manifestFile;
+  size_t nWorkers = 4;
+  size_t cacheSize = 256 * 1024 * 1024;
+  uint64_t freshness = 10000;
   description.add_options()
     ("help,h", "print this help message")
     ("pname,p", po::value<std::string>(&producerName), "Producer Name")
     ("aname,a", po::value<std::string>(&aaName), "Attribute Authority Name")
     ("config,c", po::value<std::string>(&configFile), "Config file path")
+    ("compress,z", po::value<int>(&compressLevel), "Compression level")
+    ("manifest,m", po::value<std::string>(&manifestFile), "Producer manifest file path")
+    ("workers,w", po::value<size_t>(&nWorkers), "Number of worker threads")
+    ("cache-size", po::value<size_t>(&cacheSize), "Content cache size in bytes")
+    ("freshness", po::value<uint64_t>(&freshness), "Content freshness in milliseconds")
     ;
 
   po::variables_map vm;
@@ -82,64 +104,38 @@ main(int argc, char** argv)
     return 0;
   }
 
+  if (compressLevel < 0 || compressLevel > 9) {
+    std::cerr << "ERROR: " << "compression level must be between 0 and 9" << std::endl;
+    printUsage(std::cerr, argv[0]);
+    return 1;
+  }
+
   std::unique_ptr<boost::asio::io_service> io_service(new boost::asio::io_service);
   std::unique_ptr<ndn::Face> face(new ndn::Face(*io_service));
   ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
-  ndn::security::Identity identity = ndn::ndnabacdaemon::addIdentity(producerName, keyChain);
-  ndn::security::Key key = identity.getDefaultKey();
-  ndn::security::v2::Certificate cert = key.getDefaultCertificate();
-  ndn::ndnabac::Producer producer(cert, *face, keyChain, ndn::Name(aaName));
-  // Import config for data owner.
-  std::string line;
-
-  std::cout << configFile << std::endl;
-
-  std::ifstream policyConfig(configFile);
-  if (policyConfig.is_open())
-  {
-    while (getline(policyConfig, line))
-    {
-      std::size_t pos = line.find(",");
-      if (pos == std::string::npos) {
-        std::cerr << "ERROR: " << "config format error" << std::endl;
-        return 1;
-      }
-      ndn::Name dataName = line.substr(0, pos);
-      std::string filePath = line.substr(pos+1);
-      face->setInterestFilter(ndn::Name(producerName).append(dataName),
-        [&] (const ndn::InterestFilter&, const ndn::Interest& interest) {
-          std::ifstream inputFile(filePath);
-
-          if (inputFile.is_open()) {
-            std::string content((std::istreambuf_iterator<char>(inputFile)),
-                                (std::istreambuf_iterator<char>()));
-            producer.produce(interest.getName().getSubName(1,1), reinterpret_cast<const uint8_t*>(content.data()), content.size(),
-            [&] (const ndn::Data& data) {
-              std::cout << "data successfully encrypted" << std::endl;
-              face->put(data);
-            },
-            [&] (const std::string& err) {
-              std::cout << err << std::endl;
-            });
-          }
-          inputFile.close();
-        }
-      );
+  ndn::ndnabacdaemon::ContentCache contentCache(cacheSize);
+  ndn::ndnabacdaemon::ProducerHost host(*face, keyChain, ndn::Name(aaName), nWorkers, contentCache,
+                                        ndn::time::milliseconds(freshness), compressLevel);
+  try {
+    if (!manifestFile.empty()) {
+      host.loadManifest(manifestFile);
     }
-  } else {
-    std::cerr << "ERROR: " << "config doesn't exist" << std::endl;
+    else {
+      std::cout << configFile << std::endl;
+      host.addTenant(ndn::Name(producerName), configFile);
+    }
+  }
+  catch (const ndn::ndnabacdaemon::ProducerHost::Error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
     printUsage(std::cerr, argv[0]);
     return 1;
   }
-  policyConfig.close();
+  std::cout << "serving " << host.size() << " producers" << std::endl;
 
-  try {
-    boost::asio::io_service::work ioServiceWork(*io_service);
-    io_service->run();
-  }
-  catch (const std::exception& e) {
-    std::cout << "Start IO service or Face failed" << std::endl;
-    return 1;
+  ndn::ndnabacdaemon::IoServiceManager ioServiceManager(*io_service, *face);
+  for (const auto& prefix : host.getPrefixes()) {
+    ioServiceManager.addPrefix(prefix);
   }
+  ioServiceManager.run();
   return 0;
 }
@@ -30,6 +30,7 @@
 
 #include "abac-identity.hpp"
 #include "ndnabacdaemon-common.hpp"
+#include "io-service-manager.hpp"
 
 ndn::security::v2::Certificate
 loadCertificate(const std::string& fileName)
@@ -128,13 +129,8 @@ main(int argc, char** argv)
     return 1;
   }
   attrConfig.close();
-  try {
-    boost::asio::io_service::work ioServiceWork(*io_service);
-    io_service->run();
-  }
-  catch (const std::exception& e) {
-    std::cout << "Start IO service or Face failed" << std::endl;
-    return 1;
-  }
+  ndn::ndnabacdaemon::IoServiceManager ioServiceManager(*io_service, *face);
+  ioServiceManager.addPrefix(ndn::Name(tokenIssuerName));
+  ioServiceManager.run();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include "consumer-service.hpp"
+#include "content-compression.hpp"
+
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include <deque>
+#include <istream>
+#include <memory>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+namespace local = boost::asio::local;
+
+// longest request line a client may send
+static const size_t MAX_REQUEST_SIZE = 8192;
+
+class ConsumerService::Session : public std::enable_shared_from_this<Session>
+{
+public:
+  Session(ConsumerService& service, boost::asio::io_service& io)
+    : m_service(service)
+    , m_socket(io)
+    , m_input(MAX_REQUEST_SIZE)
+    , m_isReadClosed(false)
+    , m_nPending(0)
+  {
+  }
+
+  local::stream_protocol::socket&
+  getSocket()
+  {
+    return m_socket;
+  }
+
+  void
+  read()
+  {
+    auto self = shared_from_this();
+    boost::asio::async_read_until(m_socket, m_input, '\n',
+      [self] (const boost::system::error_code& error, size_t) {
+        if (error == boost::asio::error::eof) {
+          // the client half-closed, answer what it already asked for
+          self->m_isReadClosed = true;
+          self->closeIfDone();
+          return;
+        }
+        if (error) {
+          self->close();
+          return;
+        }
+        std::istream is(&self->m_input);
+        std::string line;
+        std::getline(is, line);
+        self->handleRequest(line);
+        self->read();
+      });
+  }
+
+private:
+  struct Response
+  {
+    std::string header;
+    ConstBufferPtr payload;
+  };
+
+  void
+  handleRequest(const std::string& line)
+  {
+    std::size_t pos = line.find(",");
+    if (pos == std::string::npos) {
+      send(Response{"ERR " + line + " request format error\n", nullptr});
+      return;
+    }
+    Name name;
+    try {
+      name = Name(line.substr(0, pos)).append(Name(line.substr(pos + 1)));
+    }
+    catch (const tlv::Error& e) {
+      send(Response{"ERR " + line + " " + e.what() + "\n", nullptr});
+      return;
+    }
+
+    auto self = shared_from_this();
+    ++m_nPending;
+    m_service.fetch(name,
+      [self, name] (const ConstBufferPtr& content) {
+        --self->m_nPending;
+        // the write completes after the callback returns, so keep a borrowed payload alive
+        ConstBufferPtr payload = content.use_count() == 0 ? std::make_shared<const Buffer>(*content)
+                                                          : content;
+        self->send(Response{"OK " + name.toUri() + " " + std::to_string(payload->size()) + "\n",
+                            payload});
+      },
+      [self, name] (const std::string& err) {
+        --self->m_nPending;
+        self->send(Response{"ERR " + name.toUri() + " " + err + "\n", nullptr});
+      });
+  }
+
+  void
+  send(Response&& response)
+  {
+    if (!m_socket.is_open()) {
+      return;
+    }
+    m_output.push_back(std::move(response));
+    if (m_output.size() == 1) {
+      write();
+    }
+  }
+
+  void
+  write()
+  {
+    const Response& response = m_output.front();
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(response.header));
+    if (response.payload != nullptr) {
+      buffers.push_back(boost::asio::buffer(response.payload->data(), response.payload->size()));
+    }
+
+    auto self = shared_from_this();
+    boost::asio::async_write(m_socket, buffers,
+      [self] (const boost::system::error_code& error, size_t) {
+        // the queue is only cleared here, so the buffers in flight stay alive
+        if (error || !self->m_socket.is_open()) {
+          self->m_output.clear();
+          self->close();
+          return;
+        }
+        self->m_output.pop_front();
+        if (!self->m_output.empty()) {
+          self->write();
+        }
+        else {
+          self->closeIfDone();
+        }
+      });
+  }
+
+  void
+  closeIfDone()
+  {
+    if (m_isReadClosed && m_nPending == 0 && m_output.empty()) {
+      close();
+    }
+  }
+
+  void
+  close()
+  {
+    boost::system::error_code error;
+    m_socket.close(error);
+  }
+
+private:
+  ConsumerService& m_service;
+  local::stream_protocol::socket m_socket;
+  boost::asio::streambuf m_input;
+  std::deque<Response> m_output;
+  bool m_isReadClosed;
+  size_t m_nPending;
+};
+
+ConsumerService::ConsumerService(boost::asio::io_service& io, ndnabac::Consumer& consumer,
+                                 const Name& tokenIssuerName, ContentCache& cache,
+                                 time::milliseconds freshnessPeriod, bool wantsCompression)
+  : m_ioService(io)
+  , m_consumer(consumer)
+  , m_tokenIssuerName(tokenIssuerName)
+  , m_cache(cache)
+  , m_freshnessPeriod(freshnessPeriod)
+  , m_wantsCompression(wantsCompression)
+  , m_acceptor(io)
+{
+}
+
+void
+ConsumerService::listen(const std::string& socketPath)
+{
+  // only replace a stale socket, never a file given by mistake
+  struct stat status;
+  if (::lstat(socketPath.c_str(), &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      throw Error(socketPath + " exists and is not a socket");
+    }
+    ::unlink(socketPath.c_str());
+  }
+  m_socketPath = socketPath;
+
+  local::stream_protocol::endpoint endpoint(m_socketPath);
+  m_acceptor.open(endpoint.protocol());
+  m_acceptor.bind(endpoint);
+  m_acceptor.listen();
+  accept();
+}
+
+void
+ConsumerService::accept()
+{
+  auto session = std::make_shared<Session>(*this, m_ioService);
+  m_acceptor.async_accept(session->getSocket(),
+    [this, session] (const boost::system::error_code& error) {
+      if (error == boost::asio::error::operation_aborted) {
+        return;
+      }
+      if (!error) {
+        session->read();
+      }
+      accept();
+    });
+}
+
+void
+ConsumerService::fetch(const Name& name, const ContentCallback& onContent,
+                       const ErrorCallback& onError)
+{
+  ConstBufferPtr cached = m_cache.find(name);
+  if (cached != nullptr) {
+    onContent(cached);
+    return;
+  }
+
+  auto it = m_pending.find(name);
+  if (it != m_pending.end()) {
+    it->second.onContent.push_back(onContent);
+    it->second.onError.push_back(onError);
+    return;
+  }
+  PendingRequest& pending = m_pending[name];
+  pending.onContent.push_back(onContent);
+  pending.onError.push_back(onError);
+
+  // the cache and the coalescing stay keyed by the plain name
+  Name requestName = m_wantsCompression ? Name(name).append(COMPRESSED_COMPONENT) : name;
+  m_consumer.consume(requestName, m_tokenIssuerName,
+    [this, name] (const Buffer& result) {
+      PendingRequest pending = std::move(m_pending[name]);
+      m_pending.erase(name);
+
+      ConstBufferPtr content;
+      if (!m_wantsCompression && !m_cache.isCacheable(result.size(), m_freshnessPeriod)) {
+        // hand out the library's buffer without copying it
+        content = ConstBufferPtr(ConstBufferPtr(), &result);
+        for (const auto& callback : pending.onContent) {
+          callback(content);
+        }
+        return;
+      }
+
+      content = std::make_shared<const Buffer>(result);
+      try {
+        if (m_wantsCompression) {
+          content = decompressContent(content);
+        }
+      }
+      catch (const std::exception& e) {
+        for (const auto& callback : pending.onError) {
+          callback(e.what());
+        }
+        return;
+      }
+
+      m_cache.insert(name, content, m_freshnessPeriod);
+      for (const auto& callback : pending.onContent) {
+        callback(content);
+      }
+    },
+    [this, name] (const std::string& err) {
+      PendingRequest pending = std::move(m_pending[name]);
+      m_pending.erase(name);
+      for (const auto& callback : pending.onError) {
+        callback(err);
+      }
+    });
+}
+
+void
+ConsumerService::stop()
+{
+  boost::system::error_code error;
+  m_acceptor.close(error);
+  if (!m_socketPath.empty()) {
+    ::unlink(m_socketPath.c_str());
+  }
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_CONSUMER_SERVICE_HPP
+#define NDNABACDAEMON_DAEMON_CONSUMER_SERVICE_HPP
+
+#include <ndnabac/consumer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "content-cache.hpp"
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// Serves consume requests from local clients over a Unix domain socket.
+//
+// Clients send one "/Producer,/data" line per request and may pipeline many
+// requests on one connection.  Each result is streamed back as
+// "OK <name> <length>\n" followed by the payload, or "ERR <name> <reason>\n".
+// All work runs on the io_service thread, which also drives the Face.
+class ConsumerService : private boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  typedef std::function<void(const ConstBufferPtr&)> ContentCallback;
+  typedef std::function<void(const std::string&)> ErrorCallback;
+
+  // When @p wantsCompression is set, contents are requested in the framed form
+  // that compressing producers serve and are decoded on arrival.
+  ConsumerService(boost::asio::io_service& io, ndnabac::Consumer& consumer,
+                  const Name& tokenIssuerName, ContentCache& cache,
+                  time::milliseconds freshnessPeriod, bool wantsCompression = false);
+
+  // Start accepting clients on @p socketPath, replacing a stale socket there.
+  // Throws Error if something other than a socket exists at that path.
+  void
+  listen(const std::string& socketPath);
+
+  // Fetch and decrypt @p name, coalescing identical outstanding requests.
+  // Content that is neither decoded nor cached is passed without a copy as a
+  // pointer that owns nothing (use_count() == 0); it is valid only during the
+  // callback.  Must be called on the io_service thread.
+  void
+  fetch(const Name& name, const ContentCallback& onContent, const ErrorCallback& onError);
+
+  void
+  stop();
+
+private:
+  class Session;
+
+  void
+  accept();
+
+private:
+  boost::asio::io_service& m_ioService;
+  ndnabac::Consumer& m_consumer;
+  Name m_tokenIssuerName;
+  ContentCache& m_cache;
+  time::milliseconds m_freshnessPeriod;
+  bool m_wantsCompression;
+  boost::asio::local::stream_protocol::acceptor m_acceptor;
+  std::string m_socketPath;
+
+  struct PendingRequest
+  {
+    std::vector<ContentCallback> onContent;
+    std::vector<ErrorCallback> onError;
+  };
+  std::map<Name, PendingRequest> m_pending;
+};
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_CONSUMER_SERVICE_HPP
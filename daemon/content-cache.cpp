@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include "content-cache.hpp"
+
+#include <ndn-cxx/encoding/buffer-stream.hpp>
+#include <ndn-cxx/security/transform/block-cipher.hpp>
+#include <ndn-cxx/security/transform/buffer-source.hpp>
+#include <ndn-cxx/security/transform/stream-sink.hpp>
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+namespace tr = security::transform;
+
+static const size_t AES_KEY_SIZE = 16;
+static const size_t AES_BLOCK_SIZE = 16;
+
+ContentCache::ContentCache(size_t capacity)
+  : m_capacity(capacity)
+  , m_size(0)
+  , m_spillCapacity(0)
+  , m_spillSize(0)
+{
+}
+
+void
+ContentCache::enableSpill(const std::string& path, size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_spillPath = path;
+  m_spillCapacity = capacity;
+  m_spillKey.resize(AES_KEY_SIZE);
+  random::generateSecureBytes(m_spillKey.data(), m_spillKey.size());
+  resetSpill();
+}
+
+void
+ContentCache::insert(const Name& name, ConstBufferPtr content, time::milliseconds freshnessPeriod)
+{
+  if (content == nullptr || freshnessPeriod <= time::milliseconds::zero()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(name);
+  if (it != m_index.end()) {
+    m_size -= it->second->content->size();
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+  m_spillIndex.erase(name);
+
+  Entry entry{name, content, time::steady_clock::now() + freshnessPeriod};
+  if (content->size() > m_capacity) {
+    spill(entry);
+    return;
+  }
+
+  m_entries.push_front(std::move(entry));
+  m_index[name] = m_entries.begin();
+  m_size += content->size();
+  evict();
+}
+
+ConstBufferPtr
+ContentCache::find(const Name& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto now = time::steady_clock::now();
+
+  auto it = m_index.find(name);
+  if (it != m_index.end()) {
+    if (it->second->staleAt > now) {
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return it->second->content;
+    }
+    m_size -= it->second->content->size();
+    m_entries.erase(it->second);
+    m_index.erase(it);
+    return nullptr;
+  }
+
+  auto spilled = m_spillIndex.find(name);
+  if (spilled == m_spillIndex.end()) {
+    return nullptr;
+  }
+  if (spilled->second.staleAt <= now) {
+    m_spillIndex.erase(spilled);
+    return nullptr;
+  }
+
+  ConstBufferPtr content = unspill(spilled->second);
+  if (content == nullptr) {
+    m_spillIndex.erase(spilled);
+    return nullptr;
+  }
+  // promote back into memory when it fits
+  if (content->size() <= m_capacity) {
+    m_entries.push_front(Entry{name, content, spilled->second.staleAt});
+    m_index[name] = m_entries.begin();
+    m_size += content->size();
+    m_spillIndex.erase(spilled);
+    evict();
+  }
+  return content;
+}
+
+void
+ContentCache::evict()
+{
+  auto now = time::steady_clock::now();
+  while (m_size > m_capacity && !m_entries.empty()) {
+    const Entry& victim = m_entries.back();
+    if (victim.staleAt > now) {
+      spill(victim);
+    }
+    m_size -= victim.content->size();
+    m_index.erase(victim.name);
+    m_entries.pop_back();
+  }
+}
+
+void
+ContentCache::spill(const Entry& entry)
+{
+  if (!m_spillFile.is_open()) {
+    return;
+  }
+
+  SpillEntry spilled;
+  spilled.iv.resize(AES_BLOCK_SIZE);
+  random::generateSecureBytes(spilled.iv.data(), spilled.iv.size());
+  spilled.staleAt = entry.staleAt;
+
+  OBufferStream os;
+  tr::bufferSource(entry.content->data(), entry.content->size()) >>
+    tr::blockCipher(BlockCipherAlgorithm::AES_CBC, CipherOperator::ENCRYPT,
+                    m_spillKey.data(), m_spillKey.size(),
+                    spilled.iv.data(), spilled.iv.size()) >>
+    tr::streamSink(os);
+  ConstBufferPtr encrypted = os.buf();
+
+  if (encrypted->size() > m_spillCapacity) {
+    return;
+  }
+  if (m_spillSize + static_cast<std::streamoff>(encrypted->size()) >
+      static_cast<std::streamoff>(m_spillCapacity)) {
+    // the spill file is append-only, start over once it is full
+    resetSpill();
+  }
+
+  spilled.offset = m_spillSize;
+  spilled.length = encrypted->size();
+  m_spillFile.seekp(spilled.offset);
+  m_spillFile.write(reinterpret_cast<const char*>(encrypted->data()), encrypted->size());
+  if (!m_spillFile) {
+    resetSpill();
+    return;
+  }
+  m_spillSize += spilled.length;
+  m_spillIndex[entry.name] = std::move(spilled);
+}
+
+ConstBufferPtr
+ContentCache::unspill(const SpillEntry& entry)
+{
+  Buffer encrypted(entry.length);
+  m_spillFile.seekg(entry.offset);
+  m_spillFile.read(reinterpret_cast<char*>(encrypted.data()), encrypted.size());
+  if (!m_spillFile) {
+    m_spillFile.clear();
+    return nullptr;
+  }
+
+  OBufferStream os;
+  tr::bufferSource(encrypted.data(), encrypted.size()) >>
+    tr::blockCipher(BlockCipherAlgorithm::AES_CBC, CipherOperator::DECRYPT,
+                    m_spillKey.data(), m_spillKey.size(),
+                    entry.iv.data(), entry.iv.size()) >>
+    tr::streamSink(os);
+  return os.buf();
+}
+
+void
+ContentCache::resetSpill()
+{
+  m_spillIndex.clear();
+  m_spillSize = 0;
+  if (m_spillFile.is_open()) {
+    m_spillFile.close();
+  }
+  m_spillFile.open(m_spillPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_CONTENT_CACHE_HPP
+#define NDNABACDAEMON_DAEMON_CONTENT_CACHE_HPP
+
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <ndn-cxx/util/time.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// In-memory cache of decrypted payloads, bounded by bytes and keyed by Data name.
+//
+// Entries become stale after their FreshnessPeriod.  When a spill file is
+// enabled, entries evicted from memory are kept there encrypted with a
+// per-process AES key.  All methods are thread-safe.
+class ContentCache : private boost::noncopyable
+{
+public:
+  explicit
+  ContentCache(size_t capacity);
+
+  // Keep entries evicted from memory in @p path, up to @p capacity bytes.
+  void
+  enableSpill(const std::string& path, size_t capacity);
+
+  void
+  insert(const Name& name, ConstBufferPtr content, time::milliseconds freshnessPeriod);
+
+  // Return true if insert() may keep a content of @p size.
+  bool
+  isCacheable(size_t size, time::milliseconds freshnessPeriod) const
+  {
+    return freshnessPeriod > time::milliseconds::zero() &&
+           (size <= m_capacity || size <= m_spillCapacity);
+  }
+
+  // Return the fresh payload of @p name, or nullptr.
+  ConstBufferPtr
+  find(const Name& name);
+
+  // Bytes held in memory.
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  struct Entry
+  {
+    Name name;
+    ConstBufferPtr content;
+    time::steady_clock::TimePoint staleAt;
+  };
+  typedef std::list<Entry> EntryList;
+
+  struct SpillEntry
+  {
+    std::streamoff offset;
+    size_t length;
+    Buffer iv;
+    time::steady_clock::TimePoint staleAt;
+  };
+
+  void
+  evict();
+
+  void
+  spill(const Entry& entry);
+
+  ConstBufferPtr
+  unspill(const SpillEntry& entry);
+
+  void
+  resetSpill();
+
+private:
+  std::mutex m_mutex;
+  size_t m_capacity;
+  size_t m_size;
+  EntryList m_entries; // most recently used first
+  std::map<Name, EntryList::iterator> m_index;
+
+  std::string m_spillPath;
+  std::fstream m_spillFile;
+  size_t m_spillCapacity;
+  std::streamoff m_spillSize;
+  Buffer m_spillKey;
+  std::map<Name, SpillEntry> m_spillIndex;
+};
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_CONTENT_CACHE_HPP
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include "content-compression.hpp"
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <cstring>
+#include <limits>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+namespace bio = boost::iostreams;
+
+static const uint8_t MAGIC[] = {'V', 'O', 'Z', 0x00};
+static const size_t MAGIC_SIZE = sizeof(MAGIC);
+static const size_t HEADER_SIZE = MAGIC_SIZE + 1 + 8;
+
+// Appends to a Buffer, whose uint8_t elements back_inserter() cannot take,
+// refusing to grow past the size announced in the header.
+class BufferSink
+{
+public:
+  typedef char char_type;
+  typedef bio::sink_tag category;
+
+  BufferSink(Buffer& buffer, uint64_t limit)
+    : m_buffer(buffer)
+    , m_limit(limit)
+  {
+  }
+
+  std::streamsize
+  write(const char* s, std::streamsize n)
+  {
+    if (m_buffer.size() + n > m_limit) {
+      throw CompressionError("decompressed content exceeds announced size");
+    }
+    m_buffer.insert(m_buffer.end(), reinterpret_cast<const uint8_t*>(s),
+                    reinterpret_cast<const uint8_t*>(s) + n);
+    return n;
+  }
+
+private:
+  Buffer& m_buffer;
+  uint64_t m_limit;
+};
+
+enum CompressionMethod : uint8_t {
+  COMPRESSION_IDENTITY = 0,
+  COMPRESSION_ZLIB = 1
+};
+
+// zlib cannot expand its input by more than about 1032 times
+static const uint64_t ZLIB_MAX_RATIO = 1032;
+
+static std::shared_ptr<Buffer>
+makeHeader(CompressionMethod method, size_t size, size_t reserve)
+{
+  auto framed = std::make_shared<Buffer>(MAGIC, MAGIC + MAGIC_SIZE);
+  framed->reserve(HEADER_SIZE + reserve);
+  framed->push_back(method);
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    framed->push_back(static_cast<uint8_t>(static_cast<uint64_t>(size) >> shift));
+  }
+  return framed;
+}
+
+ConstBufferPtr
+compressContent(const uint8_t* data, size_t size, int level)
+{
+  if (level <= 0) {
+    auto framed = makeHeader(COMPRESSION_IDENTITY, size, size);
+    framed->insert(framed->end(), data, data + size);
+    return framed;
+  }
+
+  auto framed = makeHeader(COMPRESSION_ZLIB, size, size / 2);
+  {
+    bio::filtering_ostream os;
+    os.push(bio::zlib_compressor(bio::zlib_params(level)));
+    os.push(BufferSink(*framed, std::numeric_limits<uint64_t>::max()));
+    os.write(reinterpret_cast<const char*>(data), size);
+  }
+
+  if (framed->size() >= HEADER_SIZE + size) {
+    framed = makeHeader(COMPRESSION_IDENTITY, size, size);
+    framed->insert(framed->end(), data, data + size);
+  }
+  return framed;
+}
+
+ConstBufferPtr
+decompressContent(const ConstBufferPtr& content)
+{
+  if (content->size() < HEADER_SIZE ||
+      std::memcmp(content->data(), MAGIC, MAGIC_SIZE) != 0) {
+    throw CompressionError("content is not framed");
+  }
+
+  const uint8_t* header = content->data() + MAGIC_SIZE;
+  uint64_t originalSize = 0;
+  for (size_t i = 1; i <= 8; ++i) {
+    originalSize = (originalSize << 8) | header[i];
+  }
+  const uint8_t* body = content->data() + HEADER_SIZE;
+  uint64_t bodySize = content->size() - HEADER_SIZE;
+
+  switch (header[0]) {
+  case COMPRESSION_IDENTITY:
+    if (originalSize != bodySize) {
+      throw CompressionError("content size mismatch");
+    }
+    return std::make_shared<const Buffer>(body, bodySize);
+  case COMPRESSION_ZLIB:
+    if (originalSize > bodySize * ZLIB_MAX_RATIO) {
+      throw CompressionError("announced size " + std::to_string(originalSize) +
+                             " is impossible for " + std::to_string(bodySize) + " bytes");
+    }
+    break;
+  default:
+    throw CompressionError("unknown compression method " + std::to_string(header[0]));
+  }
+
+  auto result = std::make_shared<Buffer>();
+  try {
+    result->reserve(originalSize);
+    bio::filtering_istream is;
+    is.push(bio::zlib_decompressor());
+    is.push(bio::array_source(reinterpret_cast<const char*>(body), bodySize));
+    bio::copy(is, BufferSink(*result, originalSize));
+  }
+  catch (const CompressionError&) {
+    throw;
+  }
+  catch (const std::exception& e) {
+    throw CompressionError(std::string("corrupted compressed content: ") + e.what());
+  }
+
+  if (result->size() != originalSize) {
+    throw CompressionError("decompressed size mismatch");
+  }
+  return result;
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
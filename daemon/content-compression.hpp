@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_CONTENT_COMPRESSION_HPP
+#define NDNABACDAEMON_DAEMON_CONTENT_COMPRESSION_HPP
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// Compression applied by the producer before encryption.
+//
+// A consumer that can decode frames asks for them by appending
+// COMPRESSED_COMPONENT to the content name; the plain name always carries the
+// raw bytes, so old consumers and raw payloads are never mistaken for frames.
+// libndn-abac hands the consumer only the decrypted plaintext, so the method is
+// signaled in-band: a frame starts with a 4-byte magic, a method byte
+// (0 identity, 1 zlib) and the 8-byte big-endian original size.
+
+// name component selecting the framed form of a content
+const char COMPRESSED_COMPONENT[] = "zlib";
+
+class CompressionError : public std::runtime_error
+{
+public:
+  explicit
+  CompressionError(const std::string& what)
+    : std::runtime_error(what)
+  {
+  }
+};
+
+// Compress @p data with zlib at @p level (1-9).  Returns the framed payload,
+// using the identity method when @p level is 0 or compression does not make it
+// smaller.
+ConstBufferPtr
+compressContent(const uint8_t* data, size_t size, int level);
+
+// Undo compressContent().  Throws CompressionError on a payload that is not a
+// valid frame.
+ConstBufferPtr
+decompressContent(const ConstBufferPtr& content);
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_CONTENT_COMPRESSION_HPP
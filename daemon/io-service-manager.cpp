@@ -22,20 +22,44 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <algorithm>
+#include <iostream>
+
 namespace ndn {
 namespace ndnabacdaemon {
 
 IoServiceManager::IoServiceManager(boost::asio::io_service& io)
   : m_ioService(io)
+  , m_face(nullptr)
   , m_connect(true)
+  , m_retryTimer(io)
+  , m_random(std::random_device()())
+  , m_backoff(RECONNECTION_INITIAL_TIME)
+  , m_isReconnecting(false)
+  , m_isRetryScheduled(false)
+  , m_nReconnections(0)
+  , m_nLostInterests(0)
+  , m_lastReconnectionTime(0)
 {
 }
 
+IoServiceManager::IoServiceManager(boost::asio::io_service& io, Face& face)
+  : IoServiceManager(io)
+{
+  m_face = &face;
+}
+
 IoServiceManager::~IoServiceManager()
 {
   handle_stop();
 }
 
+void
+IoServiceManager::addPrefix(const Name& prefix)
+{
+  m_prefixes.push_back(prefix);
+}
+
 void
 IoServiceManager::run()
 {
@@ -45,9 +69,104 @@ IoServiceManager::run()
       m_ioService.reset();
       m_ioService.run();
     }
+    catch (const std::exception& e) {
+      onFailure(e.what());
+    }
     catch (...) {
-      std::cout << "io service failed" << std::endl;
+      onFailure("unknown error");
+    }
+  }
+}
+
+void
+IoServiceManager::onFailure(const std::string& reason)
+{
+  std::cerr << "io service failed: " << reason << std::endl;
+  if (!m_isReconnecting) {
+    m_isReconnecting = true;
+    m_failedAt = time::steady_clock::now();
+    if (m_face != nullptr) {
+      m_nLostInterests += m_face->getNPendingInterests();
+    }
+  }
+  scheduleReconnect();
+}
+
+void
+IoServiceManager::scheduleReconnect()
+{
+  if (!m_connect || m_isRetryScheduled) {
+    return;
+  }
+  m_isRetryScheduled = true;
+
+  // the wait runs on the io_service, which keeps serving everything else meanwhile
+  std::uniform_int_distribution<int64_t> jitter(m_backoff.count() / 2, m_backoff.count());
+  m_retryTimer.expires_from_now(std::chrono::milliseconds(jitter(m_random)));
+  m_retryTimer.async_wait([this] (const boost::system::error_code& error) {
+    m_isRetryScheduled = false;
+    // an earlier attempt may have succeeded late while this one was waiting
+    if (error == boost::asio::error::operation_aborted || !m_isReconnecting) {
+      return;
+    }
+    reconnect();
+  });
+  m_backoff = std::min(m_backoff * 2, time::milliseconds(RECONNECTION_TIME));
+}
+
+void
+IoServiceManager::reconnect()
+{
+  auto onReconnected = [this] {
+    if (!m_isReconnecting) {
+      return;
+    }
+    m_isReconnecting = false;
+    m_backoff = time::milliseconds(RECONNECTION_INITIAL_TIME);
+    ++m_nReconnections;
+    m_lastReconnectionTime = time::duration_cast<time::milliseconds>(
+      time::steady_clock::now() - m_failedAt).count();
+    std::cerr << "reconnected after " << m_lastReconnectionTime << " ms, "
+              << m_nLostInterests << " interests lost so far" << std::endl;
+  };
+
+  if (m_face == nullptr) {
+    onReconnected();
+    return;
+  }
+
+  // any NFD exchange forces the Face to reconnect its transport
+  if (m_prefixes.empty()) {
+    Interest interest(Name("/localhost/nfd/status/general"));
+    interest.setMustBeFresh(true);
+    // only an answer from NFD proves the connection, a timeout means it is still down
+    m_face->expressInterest(interest,
+                            [=] (const Interest&, const Data&) { onReconnected(); },
+                            [=] (const Interest&, const lp::Nack&) { onReconnected(); },
+                            [this] (const Interest&) {
+                              std::cerr << "NFD status request timed out" << std::endl;
+                              scheduleReconnect();
+                            });
+    return;
+  }
+
+  auto nRemaining = std::make_shared<size_t>(m_prefixes.size());
+  for (const auto& prefix : m_prefixes) {
+    // replace the registration of the previous attempt so the Face's table stays bounded
+    auto registered = m_registeredPrefixes.find(prefix);
+    if (registered != m_registeredPrefixes.end()) {
+      m_face->unregisterPrefix(registered->second, [] {}, [] (const std::string&) {});
     }
+    m_registeredPrefixes[prefix] = m_face->registerPrefix(prefix,
+      [=] (const Name&) {
+        if (--*nRemaining == 0) {
+          onReconnected();
+        }
+      },
+      [this] (const Name& prefix, const std::string& reason) {
+        std::cerr << "re-register " << prefix << " failed: " << reason << std::endl;
+        scheduleReconnect();
+      });
   }
 }
 
@@ -23,13 +23,28 @@
 
 #include <ndn-cxx/face.hpp>
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
+#include <map>
+#include <random>
+#include <vector>
+
+// upper bound of the reconnection backoff, in milliseconds
 #define RECONNECTION_TIME 30000
+// first reconnection backoff, in milliseconds
+#define RECONNECTION_INITIAL_TIME 100
 
 namespace ndn {
 namespace ndnabacdaemon {
 
 // The class prevent face loss connection to NFD.
+//
+// When the io_service fails, typically because NFD went away, it runs it again
+// at once and schedules a reconnection attempt on it with exponential backoff
+// and jitter, so other work on the io_service is served during an outage.  The
+// attempt re-registers the prefixes added with addPrefix() so the Face
+// reconnects to NFD.
 class IoServiceManager : private boost::noncopyable
 {
 public:
@@ -38,8 +53,15 @@ public:
 
   IoServiceManager(boost::asio::io_service& io);
 
+  // Supervise @p face, which must be driven by @p io.
+  IoServiceManager(boost::asio::io_service& io, Face& face);
+
   ~IoServiceManager();
 
+  // Register @p prefix again with NFD after every reconnection.
+  void
+  addPrefix(const Name& prefix);
+
   // Run the service's io_service loop.
   void
   run();
@@ -48,11 +70,57 @@ public:
   void
   handle_stop();
 
+  size_t
+  getNReconnections() const
+  {
+    return m_nReconnections;
+  }
+
+  // Interests pending on the Face when connections were lost.
+  size_t
+  getNLostInterests() const
+  {
+    return m_nLostInterests;
+  }
+
+  // Time from the last failure until the Face was usable again.
+  time::milliseconds
+  getLastReconnectionTime() const
+  {
+    return time::milliseconds(m_lastReconnectionTime.load());
+  }
+
+private:
+  void
+  onFailure(const std::string& reason);
+
+  // Retry reconnect() after the current backoff unless a retry is pending.
+  // Must be called on the io_service thread.
+  void
+  scheduleReconnect();
+
+  void
+  reconnect();
+
 private:
   // the IO service used by NFD connection.
   boost::asio::io_service& m_ioService;
   std::unique_ptr<boost::asio::io_service::work> m_ioServiceWork;
-  bool m_connect;
+  Face* m_face;
+  std::vector<Name> m_prefixes;
+  std::map<Name, const RegisteredPrefixId*> m_registeredPrefixes;
+  std::atomic<bool> m_connect;
+
+  boost::asio::steady_timer m_retryTimer;
+  std::mt19937 m_random;
+  time::milliseconds m_backoff;
+  time::steady_clock::TimePoint m_failedAt;
+  bool m_isReconnecting;
+  bool m_isRetryScheduled;
+
+  std::atomic<size_t> m_nReconnections;
+  std::atomic<size_t> m_nLostInterests;
+  std::atomic<int64_t> m_lastReconnectionTime;
 };
 
 } // namespace ndnabacdaemon
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// values below LINEAR_LIMIT get one bucket each, larger ones SUB_BUCKETS per power of two
+static const uint64_t LINEAR_LIMIT = 64;
+static const unsigned SUB_BUCKET_BITS = 5;
+static const uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+static const unsigned LINEAR_BITS = 6;
+static const size_t N_BUCKETS = LINEAR_LIMIT + (64 - LINEAR_BITS) * SUB_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+  : m_buckets(N_BUCKETS, 0)
+  , m_count(0)
+  , m_sum(0)
+  , m_min(std::numeric_limits<uint64_t>::max())
+  , m_max(0)
+{
+}
+
+size_t
+LatencyHistogram::bucketOf(uint64_t micros)
+{
+  if (micros < LINEAR_LIMIT) {
+    return micros;
+  }
+  unsigned exponent = 63 - __builtin_clzll(micros);
+  unsigned shift = exponent - SUB_BUCKET_BITS;
+  uint64_t sub = (micros >> shift) - SUB_BUCKETS;
+  return LINEAR_LIMIT + (exponent - LINEAR_BITS) * SUB_BUCKETS + sub;
+}
+
+uint64_t
+LatencyHistogram::lowerBound(size_t bucket)
+{
+  if (bucket < LINEAR_LIMIT) {
+    return bucket;
+  }
+  size_t index = bucket - LINEAR_LIMIT;
+  unsigned exponent = index / SUB_BUCKETS + LINEAR_BITS;
+  uint64_t sub = index % SUB_BUCKETS + SUB_BUCKETS;
+  return sub << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t
+LatencyHistogram::upperBound(size_t bucket)
+{
+  if (bucket + 1 >= N_BUCKETS) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return lowerBound(bucket + 1) - 1;
+}
+
+void
+LatencyHistogram::record(uint64_t micros)
+{
+  ++m_buckets[bucketOf(micros)];
+  ++m_count;
+  m_sum += micros;
+  m_min = std::min(m_min, micros);
+  m_max = std::max(m_max, micros);
+}
+
+uint64_t
+LatencyHistogram::percentile(double quantile) const
+{
+  if (m_count == 0) {
+    return 0;
+  }
+  uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * m_count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < m_buckets.size(); ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      return std::min(std::max(upperBound(i), m_min), m_max);
+    }
+  }
+  return m_max;
+}
+
+void
+LatencyHistogram::writeCsv(std::ostream& os) const
+{
+  os << "lower_us,upper_us,count\n";
+  for (size_t i = 0; i < m_buckets.size(); ++i) {
+    if (m_buckets[i] == 0) {
+      continue;
+    }
+    uint64_t upper = i + 1 < m_buckets.size() ? lowerBound(i + 1) : m_max + 1;
+    os << lowerBound(i) << "," << upper << "," << m_buckets[i] << "\n";
+  }
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
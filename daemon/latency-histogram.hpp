@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_LATENCY_HISTOGRAM_HPP
+#define NDNABACDAEMON_DAEMON_LATENCY_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// Log-linear histogram of latencies in microseconds, within ~3% of the value.
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  void
+  record(uint64_t micros);
+
+  uint64_t
+  count() const
+  {
+    return m_count;
+  }
+
+  uint64_t
+  min() const
+  {
+    return m_count == 0 ? 0 : m_min;
+  }
+
+  uint64_t
+  max() const
+  {
+    return m_max;
+  }
+
+  double
+  mean() const
+  {
+    return m_count == 0 ? 0 : static_cast<double>(m_sum) / m_count;
+  }
+
+  // Upper bound of the bucket holding the @p quantile (0-1) sample, clamped to the
+  // recorded maximum, so the estimate never falls below the true percentile.
+  uint64_t
+  percentile(double quantile) const;
+
+  // Write "lower_us,upper_us,count" rows for the non-empty buckets.
+  void
+  writeCsv(std::ostream& os) const;
+
+private:
+  static size_t
+  bucketOf(uint64_t micros);
+
+  static uint64_t
+  lowerBound(size_t bucket);
+
+  // Highest value that maps to @p bucket.
+  static uint64_t
+  upperBound(size_t bucket);
+
+private:
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_min;
+  uint64_t m_max;
+};
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include "output-sink.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+OutputSink::OutputSink(const std::string& path, size_t bufferSize)
+  : m_fd(STDOUT_FILENO)
+  , m_ownsFd(false)
+  , m_buffer(bufferSize)
+  , m_used(0)
+{
+  if (path != "-") {
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+      throw Error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    m_ownsFd = true;
+  }
+}
+
+OutputSink::~OutputSink()
+{
+  try {
+    flush();
+  }
+  catch (const Error&) {
+  }
+  if (m_ownsFd) {
+    ::close(m_fd);
+  }
+}
+
+void
+OutputSink::write(const uint8_t* data, size_t size)
+{
+  if (m_used + size <= m_buffer.size()) {
+    std::memcpy(m_buffer.data() + m_used, data, size);
+    m_used += size;
+    return;
+  }
+
+  if (size < m_buffer.size()) {
+    flush();
+    std::memcpy(m_buffer.data(), data, size);
+    m_used = size;
+    return;
+  }
+
+  // large payload: send buffered bytes and the payload in one call, no copy
+  struct iovec iov[2];
+  iov[0].iov_base = m_buffer.data();
+  iov[0].iov_len = m_used;
+  iov[1].iov_base = const_cast<uint8_t*>(data);
+  iov[1].iov_len = size;
+
+  ssize_t n;
+  do {
+    n = ::writev(m_fd, iov, 2);
+  } while (n < 0 && errno == EINTR);
+  if (n < 0) {
+    throw Error(std::string("write failed: ") + std::strerror(errno));
+  }
+
+  size_t written = static_cast<size_t>(n);
+  if (written < m_used) {
+    writeAll(m_buffer.data() + written, m_used - written);
+    written = 0;
+  }
+  else {
+    written -= m_used;
+  }
+  m_used = 0;
+  writeAll(data + written, size - written);
+}
+
+void
+OutputSink::flush()
+{
+  if (m_used > 0) {
+    size_t used = m_used;
+    m_used = 0;
+    writeAll(m_buffer.data(), used);
+  }
+}
+
+void
+OutputSink::writeAll(const uint8_t* data, size_t size)
+{
+  while (size > 0) {
+    ssize_t n = ::write(m_fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw Error(std::string("write failed: ") + std::strerror(errno));
+    }
+    data += n;
+    size -= n;
+  }
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
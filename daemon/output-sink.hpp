@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_OUTPUT_SINK_HPP
+#define NDNABACDAEMON_DAEMON_OUTPUT_SINK_HPP
+
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// Writes binary payloads to a file descriptor (stdout, a file or a pipe).
+//
+// Small writes are coalesced in an internal buffer; large writes bypass it and
+// go out together with any buffered bytes in a single writev().
+class OutputSink : private boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  // Open @p path for writing, truncating it; "-" selects stdout.
+  explicit
+  OutputSink(const std::string& path, size_t bufferSize = 1024 * 1024);
+
+  ~OutputSink();
+
+  void
+  write(const uint8_t* data, size_t size);
+
+  void
+  write(const Buffer& buffer)
+  {
+    write(buffer.data(), buffer.size());
+  }
+
+  void
+  flush();
+
+private:
+  void
+  writeAll(const uint8_t* data, size_t size);
+
+private:
+  int m_fd;
+  bool m_ownsFd;
+  std::vector<uint8_t> m_buffer;
+  size_t m_used;
+};
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_OUTPUT_SINK_HPP
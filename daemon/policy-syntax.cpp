@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#include "policy-syntax.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <vector>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+static uint32_t
+parseCount(const std::string& digits, const std::string& token)
+{
+  uint64_t value = 0;
+  for (char c : digits) {
+    value = value * 10 + (c - '0');
+    if (value > std::numeric_limits<uint32_t>::max()) {
+      throw PolicyError("threshold out of range in gate " + token);
+    }
+  }
+  return static_cast<uint32_t>(value);
+}
+
+static bool
+parseGate(const std::string& token, uint32_t& k, uint32_t& n)
+{
+  size_t pos = token.find("of");
+  if (pos == 0 || pos == std::string::npos || pos + 2 >= token.size()) {
+    return false;
+  }
+  std::string lhs = token.substr(0, pos);
+  std::string rhs = token.substr(pos + 2);
+  if (!std::all_of(lhs.begin(), lhs.end(), ::isdigit) ||
+      !std::all_of(rhs.begin(), rhs.end(), ::isdigit)) {
+    return false;
+  }
+  k = parseCount(lhs, token);
+  n = parseCount(rhs, token);
+  return true;
+}
+
+void
+checkPolicy(const std::string& policy)
+{
+  std::string trimmed = boost::algorithm::trim_copy(policy);
+  std::vector<std::string> tokens;
+  boost::split(tokens, trimmed, boost::is_space(), boost::token_compress_on);
+
+  // depth of the operand stack the postfix expression builds
+  uint64_t depth = 0;
+  for (const auto& token : tokens) {
+    if (token.empty()) {
+      continue;
+    }
+    if (token.find(',') != std::string::npos) {
+      throw PolicyError("attribute lists are not a policy, use a threshold gate: " + policy);
+    }
+    uint32_t k = 0;
+    uint32_t n = 0;
+    if (parseGate(token, k, n)) {
+      if (k == 0 || k > n || n > depth) {
+        throw PolicyError("invalid threshold gate " + token + " in policy: " + policy);
+      }
+      depth -= n - 1;
+    }
+    else {
+      ++depth;
+    }
+  }
+
+  if (depth != 1) {
+    throw PolicyError("malformed policy: " + policy);
+  }
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
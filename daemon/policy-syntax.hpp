@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_POLICY_SYNTAX_HPP
+#define NDNABACDAEMON_DAEMON_POLICY_SYNTAX_HPP
+
+#include <stdexcept>
+#include <string>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+class PolicyError : public std::runtime_error
+{
+public:
+  explicit
+  PolicyError(const std::string& what)
+    : std::runtime_error(what)
+  {
+  }
+};
+
+// Check that @p policy is in the postfix threshold form libndn-abac parses,
+// e.g. "attr1 attr2 1of2 attr3 2of2", so a malformed policy is rejected before
+// it is sent to a producer.  Throws PolicyError otherwise.
+void
+checkPolicy(const std::string& policy);
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_POLICY_SYNTAX_HPP
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+
+#include "producer-host.hpp"
+#include "abac-identity.hpp"
+#include "content-compression.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+ProducerHost::ProducerHost(Face& face, KeyChain& keyChain, const Name& aaName,
+                           size_t nWorkers, ContentCache& cache,
+                           time::milliseconds freshnessPeriod, int compressLevel)
+  : m_face(face)
+  , m_keyChain(keyChain)
+  , m_aaName(aaName)
+  , m_cache(cache)
+  , m_freshnessPeriod(freshnessPeriod)
+  , m_compressLevel(compressLevel)
+  , m_workerWork(new boost::asio::io_service::work(m_workerService))
+{
+  for (size_t i = 0; i < std::max<size_t>(nWorkers, 1); ++i) {
+    m_workers.emplace_back([this] { m_workerService.run(); });
+  }
+}
+
+ProducerHost::~ProducerHost()
+{
+  m_workerWork.reset();
+  m_workerService.stop();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void
+ProducerHost::addTenant(const Name& producerName, const std::string& configFile)
+{
+  for (const auto& tenant : m_tenants) {
+    if (tenant.prefix == producerName) {
+      throw Error("producer " + producerName.toUri() + " is already hosted");
+    }
+  }
+
+  std::ifstream config(configFile);
+  if (!config.is_open()) {
+    throw Error("config " + configFile + " doesn't exist");
+  }
+
+  std::vector<std::pair<Name, std::string>> files;
+  std::string line;
+  while (getline(config, line)) {
+    std::size_t pos = line.find(",");
+    if (pos == std::string::npos) {
+      throw Error("config " + configFile + " format error");
+    }
+    files.push_back(std::make_pair(Name(line.substr(0, pos)), line.substr(pos + 1)));
+  }
+
+  security::Identity identity = addIdentity(producerName, m_keyChain);
+  security::v2::Certificate cert = identity.getDefaultKey().getDefaultCertificate();
+  m_tenants.push_back(Tenant());
+  Tenant& tenant = m_tenants.back();
+  tenant.prefix = producerName;
+  tenant.producer.reset(new ndnabac::Producer(cert, m_face, m_keyChain, m_aaName));
+
+  for (const auto& file : files) {
+    Name dataName = file.first;
+    std::string filePath = file.second;
+    m_face.setInterestFilter(Name(producerName).append(dataName),
+      [this, &tenant, dataName, filePath] (const InterestFilter&, const Interest& interest) {
+        onInterest(tenant, dataName, filePath, interest);
+      });
+  }
+}
+
+void
+ProducerHost::loadManifest(const std::string& manifestFile)
+{
+  std::ifstream manifest(manifestFile);
+  if (!manifest.is_open()) {
+    throw Error("manifest " + manifestFile + " doesn't exist");
+  }
+
+  std::string line;
+  while (getline(manifest, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::size_t pos = line.find(",");
+    if (pos == std::string::npos) {
+      throw Error("manifest " + manifestFile + " format error");
+    }
+    addTenant(Name(line.substr(0, pos)), line.substr(pos + 1));
+  }
+}
+
+std::vector<Name>
+ProducerHost::getPrefixes() const
+{
+  std::vector<Name> prefixes;
+  for (const auto& tenant : m_tenants) {
+    prefixes.push_back(tenant.prefix);
+  }
+  return prefixes;
+}
+
+void
+ProducerHost::onInterest(Tenant& tenant, const Name& dataName, const std::string& filePath,
+                         const Interest& interest)
+{
+  // only consumers asking for the framed form get it, everyone else the raw bytes
+  Name prefix = Name(tenant.prefix).append(dataName);
+  const Name& interestName = interest.getName();
+  bool isFramed = interestName.size() > prefix.size() &&
+                  interestName.get(prefix.size()) == name::Component(COMPRESSED_COMPONENT);
+  Name producedName = isFramed ? Name(dataName).append(COMPRESSED_COMPONENT) : dataName;
+
+  Name key = Name(tenant.prefix).append(producedName);
+  ConstBufferPtr cached = m_cache.find(key);
+  if (cached != nullptr) {
+    produce(tenant, producedName, cached);
+    return;
+  }
+
+  // a load is already in flight, the Data it produces answers this Interest too
+  if (!m_loading.insert(key).second) {
+    return;
+  }
+
+  // read and compress off the io thread, then encrypt on it
+  m_workerService.post([this, &tenant, producedName, filePath, isFramed, key] {
+    ConstBufferPtr payload;
+    try {
+      payload = loadFile(filePath, isFramed);
+      m_cache.insert(key, payload, m_freshnessPeriod);
+    }
+    catch (const std::exception& e) {
+      std::cerr << "ERROR: cannot load " << filePath << ": " << e.what() << std::endl;
+    }
+
+    m_face.getIoService().post([this, &tenant, producedName, payload, key] {
+      m_loading.erase(key);
+      if (payload != nullptr) {
+        produce(tenant, producedName, payload);
+      }
+    });
+  });
+}
+
+ConstBufferPtr
+ProducerHost::loadFile(const std::string& filePath, bool isFramed) const
+{
+  std::ifstream inputFile(filePath, std::ios::binary);
+  if (!inputFile.is_open()) {
+    throw Error("cannot open " + filePath);
+  }
+  std::string content((std::istreambuf_iterator<char>(inputFile)),
+                      (std::istreambuf_iterator<char>()));
+  if (inputFile.bad()) {
+    throw Error("cannot read " + filePath);
+  }
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(content.data());
+
+  if (isFramed) {
+    return compressContent(bytes, content.size(), m_compressLevel);
+  }
+  return std::make_shared<const Buffer>(bytes, content.size());
+}
+
+void
+ProducerHost::produce(Tenant& tenant, const Name& dataName, const ConstBufferPtr& payload)
+{
+  tenant.producer->produce(dataName, payload->data(), payload->size(),
+    [this] (const Data& data) {
+      std::cout << "data successfully encrypted" << std::endl;
+      m_face.put(data);
+    },
+    [] (const std::string& err) {
+      std::cout << err << std::endl;
+    });
+}
+
+} // namespace ndnabacdaemon
+} // namespace ndn
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017, Regents of the University of California.
+ *
+ * This file is part of ndnabacdaemon, a certificate management system based on NDN.
+ *
+ * ndnabac is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ndnabac is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received copies of the GNU General Public License along with
+ * ndnabacdaemon, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndnabacdaemon authors and contributors.
+ */
+#ifndef NDNABACDAEMON_DAEMON_PRODUCER_HOST_HPP
+#define NDNABACDAEMON_DAEMON_PRODUCER_HOST_HPP
+
+#include <ndnabac/producer.hpp>
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "content-cache.hpp"
+
+namespace ndn {
+namespace ndnabacdaemon {
+
+// Hosts many producer identities in one process.
+//
+// All tenants share the Face, the KeyChain, a pool of worker threads that read
+// and compress files, and one cache of prepared payloads.  Encryption and
+// Face operations stay on the Face's io_service thread.
+class ProducerHost : private boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  ProducerHost(Face& face, KeyChain& keyChain, const Name& aaName,
+               size_t nWorkers, ContentCache& cache, time::milliseconds freshnessPeriod,
+               int compressLevel);
+
+  ~ProducerHost();
+
+  // Create the identity @p producerName and serve the "dataName,filePath"
+  // lines of @p configFile under it.  Throws Error if @p producerName is
+  // already hosted.
+  void
+  addTenant(const Name& producerName, const std::string& configFile);
+
+  // Add one tenant per "producerName,configFile" line of @p manifestFile.
+  void
+  loadManifest(const std::string& manifestFile);
+
+  size_t
+  size() const
+  {
+    return m_tenants.size();
+  }
+
+  // Prefixes of all hosted producers.
+  std::vector<Name>
+  getPrefixes() const;
+
+private:
+  struct Tenant
+  {
+    Name prefix;
+    std::unique_ptr<ndnabac::Producer> producer;
+  };
+
+  void
+  onInterest(Tenant& tenant, const Name& dataName, const std::string& filePath,
+             const Interest& interest);
+
+  // Read @p filePath, framing and compressing it when @p isFramed.  Runs on a
+  // worker thread.
+  ConstBufferPtr
+  loadFile(const std::string& filePath, bool isFramed) const;
+
+  void
+  produce(Tenant& tenant, const Name& dataName, const ConstBufferPtr& payload);
+
+private:
+  Face& m_face;
+  KeyChain& m_keyChain;
+  Name m_aaName;
+  ContentCache& m_cache;
+  time::milliseconds m_freshnessPeriod;
+  int m_compressLevel;
+  std::list<Tenant> m_tenants;
+  // payloads being loaded by the workers, touched only on the io thread
+  std::set<Name> m_loading;
+
+  boost::asio::io_service m_workerService;
+  std::unique_ptr<boost::asio::io_service::work> m_workerWork;
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace ndnabacdaemon
+} // namespace ndn
+
+#endif // NDNABACDAEMON_DAEMON_PRODUCER_HOST_HPP